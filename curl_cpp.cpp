@@ -21,8 +21,12 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 
 #include "curl_cpp.hpp"
+#include "curl_cpp_options.hpp"
 #include <curl/curl.h>
 
+#include <cctype>
+#include <cstring>
+
 
 using namespace curl_cpp;
 
@@ -56,6 +60,77 @@ namespace{
 
 
 
+//--- url helpers ---
+namespace{
+    std::string to_lower(const char* s, size_t n){
+        std::string r(s,n);
+        for(auto &c : r){c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));}
+        return r;
+    }
+
+    //host part of an url, without parsing it all : scheme://user@host:port/path
+    void url_host(const char* url, const char* &b, const char* &e){
+        b = std::strstr(url,"://");
+        b = b ? b+3 : url;
+        e = b + std::strcspn(b,"/?#");
+
+        for(const char* at = e; at != b; --at){ //skip user info
+            if(at[-1]=='@'){b = at; break;}
+        }
+
+        if(b != e and *b=='['){ //ipv6 : keep the brackets, as CURLUPART_HOST
+            const char* c = static_cast<const char*>(std::memchr(b,']',e-b));
+            if(c){e = c+1;}
+        }else{
+            const char* c = static_cast<const char*>(std::memchr(b,':',e-b));
+            if(c){e = c;}
+        }
+    }
+
+    //s==nullptr : no unix socket. Throws Curl_error if curl cannot set it (ex : no abstract sockets on this platform)
+    void unix_socket_set(Curl_handle &curl, const Curl_unix_socket *s){
+        Curl_unix_socket &old = curl.unix_socket;
+        if(!s and old.path.empty()){return;}
+        if(s and s->abstract == old.abstract and s->path == old.path){return;} //already set on this handle
+
+        if(!old.path.empty() and (!s or s->abstract != old.abstract)){ //unset the old option
+            const CURLoption o = old.abstract ? CURLOPT_ABSTRACT_UNIX_SOCKET : CURLOPT_UNIX_SOCKET_PATH;
+            details::curl_setopt_throw( curl_easy_setopt(curl, o, nullptr), o );
+            old = Curl_unix_socket();
+        }
+        if(s){
+            const CURLoption o = s->abstract ? CURLOPT_ABSTRACT_UNIX_SOCKET : CURLOPT_UNIX_SOCKET_PATH;
+            details::curl_setopt_throw( curl_easy_setopt(curl, o, s->path.c_str()), o );
+            old = *s;
+        }
+    }
+}//end namespace { for url helpers
+
+
+
+//=== Curl_unix_sockets ===
+
+void curl_cpp::Curl_unix_sockets::add(const std::string &host, const std::string &path){
+    sockets[to_lower(host.data(),host.size())] = Curl_unix_socket{path,false};
+}
+
+void curl_cpp::Curl_unix_sockets::add_abstract(const std::string &host, const std::string &name){
+    sockets[to_lower(host.data(),host.size())] = Curl_unix_socket{name,true};
+}
+
+void curl_cpp::Curl_unix_sockets::remove(const std::string &host){
+    sockets.erase(to_lower(host.data(),host.size()));
+}
+
+const Curl_unix_socket* curl_cpp::Curl_unix_sockets::find(const char* host, size_t size)const{
+    if(sockets.empty()){return nullptr;}
+    auto f = sockets.find(to_lower(host,size));
+    if(f == sockets.end()){return nullptr;}
+    return &f->second;
+}
+
+
+
 //=== Curl_handle ===
 
 curl_cpp::Curl_handle:: Curl_handle(){
@@ -79,6 +154,76 @@ void curl_cpp::Curl_slist_handle::append(const char*s){
     slist = curl_slist_append(slist,s);
 }
 
+//=== Curl_url ===
+
+curl_cpp::Curl_url:: Curl_url(const char* url_){
+    curlu = curl_url();
+    if(!curlu){throw Curl_error("ERROR in curl : cannot initialize curl url");}
+
+    //accept "example.com/page" (scheme guessed, as curl does with CURLOPT_URL), and schemes unknown to this libcurl
+    CURLUcode res = curl_url_set(curlu, CURLUPART_URL, url_, CURLU_GUESS_SCHEME | CURLU_NON_SUPPORT_SCHEME);
+    if(res != CURLUE_OK){
+        curl_url_cleanup(curlu);
+        throw Curl_error(std::string("ERROR in curl url, message=")+curl_url_strerror(res), url_);
+    }
+
+    char *normalized = nullptr;
+    if(curl_url_get(curlu, CURLUPART_URL, &normalized, 0) == CURLUE_OK){
+        url = normalized;
+        curl_free(normalized);
+    }else{
+        url = url_;
+    }
+
+    char *h = nullptr;
+    if(curl_url_get(curlu, CURLUPART_HOST, &h, 0) == CURLUE_OK){
+        host_ = h;
+        curl_free(h);
+    }
+}
+
+curl_cpp::Curl_url:: ~Curl_url(){
+    curl_url_cleanup(curlu);
+}
+
+//=== set options ===
+
+void details::curl_setopt_throw(CURLcode res, CURLoption opt){
+    if(res != CURLE_OK){
+        throw Curl_error("ERROR in curl setopt, option="+std::to_string(static_cast<int>(opt))+", message="+curl_easy_strerror(res));
+    }
+}
+
+//=== set url ===
+
+void details::curl_set_url(Curl_handle &curl, const char* url){
+    if(curl.curlu){
+        curl_easy_setopt(curl, CURLOPT_CURLU, nullptr);
+        curl.curlu = nullptr;
+    }
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+
+    if(curl.unix_sockets or !curl.unix_socket.path.empty()){
+        const Curl_unix_socket *s = nullptr;
+        if(curl.unix_sockets){
+            const char *b, *e;
+            url_host(url,b,e);
+            s = curl.unix_sockets->find(b, e-b);
+        }
+        unix_socket_set(curl,s);
+    }
+}
+
+void details::curl_set_url(Curl_handle &curl, const Curl_url &url){
+    if(curl.unix_sockets or !curl.unix_socket.path.empty()){
+        unix_socket_set(curl, curl.unix_sockets ? curl.unix_sockets->find(url.host()) : nullptr);
+    }
+
+    if(curl.curlu == url.get()){return;} //same url object : nothing to do
+    curl_easy_setopt(curl, CURLOPT_CURLU, url.get());
+    curl.curlu = url.get();
+}
+
 
 
 
@@ -161,13 +306,20 @@ void Curl_receive_t<std::ostream>::finish(  Curl_handle &curl, const char* url,
 //================
 //=== curl_get ===
 //================
-void details::curl_get_impl(Curl_handle &curl, const char* &url, void* append_here, size_t(*fn)(void *,size_t,size_t,void*) ){
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L); //allow redirect
+void details::curl_set_follow(Curl_handle &curl, bool follow){
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, follow ? 1L : 0L);
+}
+
+void details::curl_get_impl(Curl_handle &curl, void* append_here, size_t(*fn)(void *,size_t,size_t,void*) ){
+    curl_set_follow(curl,true); //allow redirect
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, fn);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, append_here);
 }
 
+void details::curl_get_mode(Curl_handle &curl){
+    curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L); //the POSTFIELDS of a previous post may be dead
+}
+
 
 //=== GET ===
 /*
@@ -212,9 +364,18 @@ void Curl_get_t<std::string>::run(Curl_handle &h, const char* url, std::string
 
 //=== POST ===
 
+size_t details::curl_discard(void *, size_t size, size_t nmemb, void *)noexcept{
+    return size * nmemb;
+}
 
-void Curl_send_t<std::string>::send(Curl_handle &curl, const char* url, const std::string &data){
-    curl_easy_setopt(curl, CURLOPT_URL, url);
+void details::curl_post_impl(Curl_handle &curl){
+    curl_set_follow(curl,false); //a redirected POST is sent again as a GET, without its body
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_discard);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+}
+
+
+void Curl_send_t<std::string>::send(Curl_handle &curl, const char*, const std::string &data){
     curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data.c_str() );
     curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, data.size() ); //USE string size instead of default C strlen, as string may contains '\0'
 }
@@ -226,8 +387,8 @@ void  Curl_send_t<std::string>::finish ( Curl_handle &curl, const char* url, con
 
 
 
-void Curl_send_t<const char*>::send(Curl_handle &curl,const char* url, const char *data){
-    curl_easy_setopt(curl, CURLOPT_URL, url);
+void Curl_send_t<const char*>::send(Curl_handle &curl,const char*, const char *data){
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, -1L); //strlen, a previous post may have set a size
     curl_easy_setopt(curl, CURLOPT_POSTFIELDS, data );
 }
 
@@ -257,6 +418,20 @@ namespace{
     curl_post_get(ct,s,out);
     curl_post_get(ct,ct,out);
 
+    Curl_url u(s);
+    Curl_handle h;
+    curl_get(h,u,out);
+    curl_post(h,u,s);
+    curl_post_get(h,u,ct,out);
+
+    constexpr auto preset = curl_options(
+        curl_option<CURLOPT_TIMEOUT>(10),
+        curl_option<CURLOPT_USERAGENT>("curl_cpp")
+    ) | curl_option<CURLOPT_WRITEFUNCTION>(&Curl_receive_t<std::string>::receive);
+    Curl_handle hp(preset);
+    Curl_slist_handle headers;
+    curl_option<CURLOPT_HTTPHEADER>(headers.get()).apply(hp);
+
 
     to_cstring(s);
     to_cstring(ct);
@@ -24,9 +24,11 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "curl_cpp_errors.hpp"
 
+#include <map>
 #include <string>
 #include <ostream>
 #include <type_traits>
+#include <utility>
 
 #include <curl/curl.h>
 
@@ -50,7 +52,25 @@ Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 /// Set curl options :
 ///   Curl_handle h;
 ///   curl_easy_setopt(h,CURL_OPTION,...);
-///   NOTE : h should NOT be recycled among multiple calls to curl_get and curl_post.
+///   h can be reused among calls to curl_get, curl_post and curl_post_get : each call sets the url,
+///   the redirection policy and the write callback. curl_post discards the server answer.
+///   curl_get and curl_post_get follow redirections (CURLOPT_FOLLOWLOCATION), curl_post does not :
+///   a redirected POST would be sent again as a GET, and its body lost.
+///
+/// Options applied once, when the handle is created : see curl_cpp_options.hpp
+///   Curl_handle h(preset);
+///
+/// Pre-parsed url, reusable among calls :
+///   Curl_url u("http://example.com");
+///   curl_get(h,u,append_here);
+///
+/// Route some hosts to a unix domain socket (ex : local sidecar proxy) :
+///   Curl_unix_sockets sockets;
+///   sockets.add("sidecar","/run/sidecar.sock");
+///   sockets.add_abstract("other","other_socket");  //linux abstract namespace
+///   h.unix_sockets = &sockets;                     //must outlive h
+///   curl_get(h,"http://sidecar/page",append_here);
+///   NOTE : the route is chosen from the requested url, redirections keep it.
 ///
 
 
@@ -92,6 +112,31 @@ struct To_cstring_t<char[N]>{
 
 
 
+//===========================
+//=== Unix domain sockets ===
+//===========================
+
+struct Curl_unix_socket{
+    std::string path;
+    bool        abstract = false; //linux abstract namespace (no file)
+};
+
+//host -> unix socket. Hosts are case insensitive, ports are ignored.
+struct Curl_unix_sockets{
+    void add         (const std::string &host, const std::string &path);
+    void add_abstract(const std::string &host, const std::string &name);
+    void remove      (const std::string &host);
+
+    //nullptr if host is not routed
+    const Curl_unix_socket* find(const char* host, size_t size)const;
+    const Curl_unix_socket* find(const std::string &host)const{return find(host.data(),host.size());}
+
+    std::map<std::string,Curl_unix_socket> sockets; //lower case host -> socket
+};
+
+
+
+
 //=========================
 //=== RAII Curl_handle  ===
 //=========================
@@ -100,14 +145,25 @@ struct Curl_handle{
     Curl_handle();
     ~Curl_handle();
 
+    //apply a Curl_options preset once, at creation (see curl_cpp_options.hpp)
+    template<typename Options, typename = std::enable_if_t<Options::is_curl_options> >
+    explicit Curl_handle(const Options &o):Curl_handle(){o.apply(*this);}
+
     //movable, not copiable
-    Curl_handle(Curl_handle&&)=default;
+    Curl_handle(Curl_handle&&o):curl(o.curl),curlu(o.curlu),unix_sockets(o.unix_sockets),unix_socket(std::move(o.unix_socket)){
+        o.curl=nullptr; o.curlu=nullptr;
+    }
     Curl_handle(const Curl_handle&)=delete;
     Curl_handle& operator=(const Curl_handle&)=delete;
 
     CURL* curl=nullptr;
     operator CURL*(){return curl;}
     CURL* get()     {return curl;}
+
+    CURLU* curlu=nullptr; //url set with CURLOPT_CURLU, it takes precedence over CURLOPT_URL
+
+    const Curl_unix_sockets *unix_sockets=nullptr; //routing table, nullptr = none. Not owned.
+    Curl_unix_socket         unix_socket;          //socket currently set on the handle, empty path = none
 };
 
 
@@ -116,7 +172,7 @@ struct Curl_slist_handle{
     ~Curl_slist_handle();
 
     //movable, not copiable
-    Curl_slist_handle(Curl_slist_handle&&)=default;
+    Curl_slist_handle(Curl_slist_handle&&o):slist(o.slist){o.slist=nullptr;}
     Curl_slist_handle(const Curl_slist_handle&)=delete;
     Curl_slist_handle& operator=(const Curl_slist_handle&)=delete;
 
@@ -129,6 +185,48 @@ struct Curl_slist_handle{
 
 };
 
+
+//Parsed url, use it instead of a string to parse the url only once
+struct Curl_url{
+    explicit Curl_url(const char* url);
+    explicit Curl_url(const std::string &url):Curl_url(url.c_str()){}
+    ~Curl_url();
+
+    //movable, not copiable
+    Curl_url(Curl_url&&o):curlu(o.curlu),url(std::move(o.url)),host_(std::move(o.host_)){o.curlu=nullptr;}
+    Curl_url(const Curl_url&)=delete;
+    Curl_url& operator=(const Curl_url&)=delete;
+
+    CURLU* curlu=nullptr;
+    operator CURLU*()const{return curlu;}
+    CURLU* get()const     {return curlu;}
+
+    const char*        c_str()const{return url.c_str();} //normalized url, for error messages
+    const std::string& host ()const{return host_;}
+
+private:
+    std::string url;
+    std::string host_;
+};
+
+template<>
+struct To_cstring_t<Curl_url>{
+    static constexpr bool value = true;
+    static const char* run(const Curl_url &u){return u.c_str();}
+};
+
+
+namespace details{
+    //bury curl specific code here
+    void curl_set_url(Curl_handle &curl, const char* url);
+    void curl_set_url(Curl_handle &curl, const Curl_url &url);
+    void curl_set_follow(Curl_handle &curl, bool follow); //set for each request, presets may have changed it
+
+    template<typename Url_t>
+    void url_set(Curl_handle &curl, const Url_t &url){curl_set_url(curl, curl_cpp::to_cstring(url));}
+    inline void url_set(Curl_handle &curl, const Curl_url &url){curl_set_url(curl, url);}
+}
+
 //====================
 //=== curl_receive ===
 //====================
@@ -234,14 +332,17 @@ struct Curl_send_t<char[N]>:Curl_send_t<const char*>{};
 //================
 namespace details{
     //bury curl specific code here
-    void curl_get_impl(Curl_handle &curl, const char* &url, void* append_here, size_t(*fn)(void *,size_t,size_t,void*) );
+    //the url is already set, only the per request fields are set here
+    void curl_get_impl(Curl_handle &curl, void* append_here, size_t(*fn)(void *,size_t,size_t,void*) );
+    void curl_get_mode(Curl_handle &curl); //back to GET, after a curl_post on the same handle
 
     //prepare and get
     template<typename T>
     std::enable_if_t< Curl_receive_t<T>::value >
     curl_get_t(Curl_handle &curl, const char* url, T  &append_here){
+        curl_get_mode(curl);
         auto p = Curl_receive_t<T>::prepare(curl,url,append_here);
-        curl_get_impl(curl, url, static_cast<void*>(&p),  Curl_receive_t<T>::receive );
+        curl_get_impl(curl, static_cast<void*>(&p),  Curl_receive_t<T>::receive );
         Curl_receive_t<T>::finish(curl,url,append_here,p);
     }
 }
@@ -252,6 +353,7 @@ template<typename Url_t , typename App_t >
 std::enable_if_t<To_cstring_t<Url_t>::value and Curl_receive_t<App_t>::value >
 curl_get(Curl_handle &h, const Url_t &url, App_t &append_here){
     const char * u = curl_cpp::to_cstring( url);
+    details::url_set(h,url);
     details::curl_get_t(h,u, append_here);
 }
 
@@ -260,6 +362,7 @@ std::enable_if_t< To_cstring_t<Url_t>::value and Curl_receive_t<App_t>::value >
 curl_get(const Url_t &url, App_t &append_here){
     Curl_handle h;
     const char * u = curl_cpp::to_cstring( url);
+    details::url_set(h,url);
     details::curl_get_t(h, u  , append_here);
 }
 
@@ -279,11 +382,17 @@ struct Curl_send_t<const char*>{
 */
 
 namespace details{
+    //bury curl specific code here
+    //no redirection, and the server answer is discarded : the write callback of a previous curl_get is dead
+    void   curl_post_impl(Curl_handle &curl);
+    size_t curl_discard  (void *ptr, size_t size, size_t nmemb, void *stream)noexcept;
+
     //prepare and get
     template<typename T>
     std::enable_if_t< Curl_send_t<T>::value >
     curl_post_t(Curl_handle &curl, const char* url, const T  &send_me){
         //curl_post_impl(curl, url, static_cast<void*>() );
+        curl_post_impl(curl);
         Curl_send_t<T>::send  (curl,url,send_me);
         Curl_send_t<T>::finish(curl,url,send_me);
     }
@@ -301,6 +410,7 @@ std::enable_if_t<
 curl_post(const Url_t &url, const Send_t &data){
     Curl_handle h;
     const char* u = curl_cpp::to_cstring(url);
+    details::url_set(h,url);
     details::curl_post_t(h, u, data );
 }
 
@@ -311,6 +421,7 @@ std::enable_if_t<
 >
 curl_post(Curl_handle &h, const Url_t &url, const Send_t &data){
     const char* u = curl_cpp::to_cstring(url);
+    details::url_set(h,url);
     details::curl_post_t(h, u, data );
 }
 
@@ -324,10 +435,12 @@ namespace details{
     std::enable_if_t< Curl_send_t<Send_t>::value and Curl_receive_t<Receive_t>::value >
     curl_post_get_t(Curl_handle &curl, const char* url, const Send_t  &send_me, Receive_t& append_here ){
         //curl_post_impl(curl, url, static_cast<void*>() );
+        //the transfer is done once, by the receiver : its finish checks and cleans up what its prepare did.
+        //Curl_send_t<Send_t>::finish is not called.
         Curl_send_t<Send_t>::send  (curl,url,send_me);
         auto p = Curl_receive_t<Receive_t>::prepare(curl,url,append_here);
-        curl_get_impl(curl, url, static_cast<void*>(&p),  Curl_receive_t<Receive_t>::receive );
-        Curl_send_t<Send_t>::finish(curl,url,send_me);
+        curl_get_impl(curl, static_cast<void*>(&p),  Curl_receive_t<Receive_t>::receive );
+        Curl_receive_t<Receive_t>::finish(curl,url,append_here,p);
     }
 }
 
@@ -347,7 +460,7 @@ curl_post_get(const Url_t &url, const Send_t &data, Receive_t &receive){
 
     Curl_handle h;
     const char* u = curl_cpp::to_cstring(url);
-
+    details::url_set(h,url);
     details::curl_post_get_t(h, u, data,receive );
 }
 
@@ -362,6 +475,7 @@ curl_post_get(Curl_handle &h, const Url_t &url, const Send_t &data, Receive_t &r
     static_assert(std::is_reference <decltype(data)>::value,"" );
 
     const char* u = curl_cpp::to_cstring(url);
+    details::url_set(h,url);
     details::curl_post_get_t(h, u, data,receive );
 }
 
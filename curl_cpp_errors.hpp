@@ -44,6 +44,12 @@ struct Curl_error_http:Curl_error{
     long error_number = 0; //0=undefined
 };
 
+//Downloaded data does not match the expected checksum
+struct Curl_error_hash:Curl_error{
+    typedef Curl_error base_type;
+    using base_type::base_type;
+};
+
 
 }
 
@@ -0,0 +1,582 @@
+/*
+Copyright (C) 2024 Pierre BLAVY
+
+This program (curl_cpp) is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software Foundation,
+Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+//This program uses curl, see curl.se
+
+
+#include "curl_cpp_hash.hpp"
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  #include <immintrin.h>
+  #define CURL_CPP_CRC32C_SSE42
+  #define CURL_CPP_SHA256_SHANI
+#else
+  #if defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+    #define CURL_CPP_CRC32C_ARM
+  #endif
+  #if defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+    #include <arm_neon.h>
+    #define CURL_CPP_SHA256_ARM
+  #endif
+#endif
+
+
+using namespace curl_cpp;
+
+
+
+//--- helpers ---
+namespace{
+    inline std::uint32_t load32_le(const unsigned char *p){
+        return  std::uint32_t(p[0])        | (std::uint32_t(p[1]) <<  8) |
+               (std::uint32_t(p[2]) << 16) | (std::uint32_t(p[3]) << 24);
+    }
+
+    inline std::uint64_t load64_le(const unsigned char *p){
+        return std::uint64_t(load32_le(p)) | (std::uint64_t(load32_le(p+4)) << 32);
+    }
+
+    inline std::uint32_t load32_be(const unsigned char *p){
+        return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) |
+               (std::uint32_t(p[2]) <<  8) |  std::uint32_t(p[3]);
+    }
+
+    inline std::uint64_t rotl64(std::uint64_t x, int r){return (x << r) | (x >> (64 - r));}
+    inline std::uint32_t rotr32(std::uint32_t x, int r){return (x >> r) | (x << (32 - r));}
+
+    //big endian hex of the n lowest bytes of x
+    std::string to_hex(std::uint64_t x, size_t n){
+        static const char digits[] = "0123456789abcdef";
+        std::string r(2*n,'0');
+        for(size_t i = 0; i < n; ++i){
+            const unsigned b = (x >> (8*(n-1-i))) & 0xFF;
+            r[2*i]   = digits[b >> 4];
+            r[2*i+1] = digits[b & 0xF];
+        }
+        return r;
+    }
+}
+
+
+
+//==============
+//=== Crc32c ===
+//==============
+namespace{
+    //slice by 8, reflected polynomial 0x82F63B78
+    struct Crc32c_table{
+        std::uint32_t t[8][256];
+        Crc32c_table(){
+            for(std::uint32_t i = 0; i < 256; ++i){
+                std::uint32_t c = i;
+                for(int k = 0; k < 8; ++k){c = (c >> 1) ^ (0x82F63B78 & (0u - (c & 1)));}
+                t[0][i] = c;
+            }
+            for(std::uint32_t i = 0; i < 256; ++i){
+                for(int k = 1; k < 8; ++k){t[k][i] = (t[k-1][i] >> 8) ^ t[0][t[k-1][i] & 0xFF];}
+            }
+        }
+    };
+
+    std::uint32_t crc32c_sw(std::uint32_t crc, const unsigned char *p, size_t n){
+        static const Crc32c_table table;
+        const auto &t = table.t;
+
+        while(n >= 8){
+            const std::uint32_t lo = crc ^ load32_le(p);
+            const std::uint32_t hi = load32_le(p+4);
+            crc = t[7][ lo        & 0xFF] ^ t[6][(lo >>  8) & 0xFF] ^
+                  t[5][(lo >> 16) & 0xFF] ^ t[4][ lo >> 24        ] ^
+                  t[3][ hi        & 0xFF] ^ t[2][(hi >>  8) & 0xFF] ^
+                  t[1][(hi >> 16) & 0xFF] ^ t[0][ hi >> 24        ];
+            p += 8; n -= 8;
+        }
+        while(n--){crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];}
+        return crc;
+    }
+
+
+#if defined(CURL_CPP_CRC32C_SSE42)
+    __attribute__((target("sse4.2")))
+    std::uint32_t crc32c_hw(std::uint32_t crc, const unsigned char *p, size_t n){
+      #if defined(__x86_64__)
+        std::uint64_t c = crc;
+        while(n >= 8){
+            std::uint64_t v; std::memcpy(&v, p, 8);
+            c = _mm_crc32_u64(c, v);
+            p += 8; n -= 8;
+        }
+        crc = static_cast<std::uint32_t>(c);
+      #endif
+        while(n >= 4){
+            std::uint32_t v; std::memcpy(&v, p, 4);
+            crc = _mm_crc32_u32(crc, v);
+            p += 4; n -= 4;
+        }
+        while(n--){crc = _mm_crc32_u8(crc, *p++);}
+        return crc;
+    }
+
+    bool crc32c_hw_ok(); //known answer check, see below
+
+    bool crc32c_has_hw(){
+        static const bool r = __builtin_cpu_supports("sse4.2") and crc32c_hw_ok();
+        return r;
+    }
+
+#elif defined(CURL_CPP_CRC32C_ARM)
+    std::uint32_t crc32c_hw(std::uint32_t crc, const unsigned char *p, size_t n){
+        while(n >= 8){
+            std::uint64_t v; std::memcpy(&v, p, 8);
+            crc = __crc32cd(crc, v);
+            p += 8; n -= 8;
+        }
+        while(n--){crc = __crc32cb(crc, *p++);}
+        return crc;
+    }
+
+    bool crc32c_hw_ok();
+
+    bool crc32c_has_hw(){
+        static const bool r = crc32c_hw_ok();
+        return r;
+    }
+#endif
+
+#if defined(CURL_CPP_CRC32C_SSE42) || defined(CURL_CPP_CRC32C_ARM)
+    //the hardware path is only used if it gives the known answer
+    bool crc32c_hw_ok(){
+        const char *v = "123456789";
+        return ~crc32c_hw(0xFFFFFFFF, reinterpret_cast<const unsigned char*>(v), 9) == 0xE3069283;
+    }
+#endif
+}
+
+
+void Crc32c::update(const void* data, size_t size){
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+#if defined(CURL_CPP_CRC32C_SSE42) || defined(CURL_CPP_CRC32C_ARM)
+    if(crc32c_has_hw()){crc = crc32c_hw(crc, p, size); return;}
+#endif
+    crc = crc32c_sw(crc, p, size);
+}
+
+std::string Crc32c::hex()const{
+    return to_hex(value(),4);
+}
+
+
+
+//=============
+//=== Xxh64 ===
+//=============
+namespace{
+    const std::uint64_t xxh_p1 = 11400714785074694791ULL;
+    const std::uint64_t xxh_p2 = 14029467366897019727ULL;
+    const std::uint64_t xxh_p3 =  1609587929392839161ULL;
+    const std::uint64_t xxh_p4 =  9650029242287828579ULL;
+    const std::uint64_t xxh_p5 =  2870177450012600261ULL;
+
+    inline std::uint64_t xxh_round(std::uint64_t acc, std::uint64_t input){
+        acc += input * xxh_p2;
+        acc  = rotl64(acc, 31);
+        return acc * xxh_p1;
+    }
+
+    inline std::uint64_t xxh_merge(std::uint64_t acc, std::uint64_t val){
+        acc ^= xxh_round(0, val);
+        return acc * xxh_p1 + xxh_p4;
+    }
+}
+
+
+Xxh64::Xxh64(std::uint64_t seed_):seed(seed_){
+    v[0] = seed + xxh_p1 + xxh_p2;
+    v[1] = seed + xxh_p2;
+    v[2] = seed;
+    v[3] = seed - xxh_p1;
+}
+
+void Xxh64::update(const void* data, size_t size){
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    total += size;
+
+    //complete the pending stripe
+    if(buffered != 0){
+        const size_t n = std::min(size, 32 - buffered);
+        std::memcpy(buffer + buffered, p, n);
+        buffered += n; p += n; size -= n;
+        if(buffered < 32){return;}
+        for(int i = 0; i < 4; ++i){v[i] = xxh_round(v[i], load64_le(buffer + 8*i));}
+        buffered = 0;
+    }
+
+    while(size >= 32){
+        v[0] = xxh_round(v[0], load64_le(p     ));
+        v[1] = xxh_round(v[1], load64_le(p +  8));
+        v[2] = xxh_round(v[2], load64_le(p + 16));
+        v[3] = xxh_round(v[3], load64_le(p + 24));
+        p += 32; size -= 32;
+    }
+
+    std::memcpy(buffer, p, size);
+    buffered = size;
+}
+
+std::uint64_t Xxh64::value()const{
+    std::uint64_t h;
+    if(total >= 32){
+        h = rotl64(v[0],1) + rotl64(v[1],7) + rotl64(v[2],12) + rotl64(v[3],18);
+        for(int i = 0; i < 4; ++i){h = xxh_merge(h, v[i]);}
+    }else{
+        h = seed + xxh_p5;
+    }
+    h += total;
+
+    const unsigned char *p   = buffer;
+    const unsigned char *end = buffer + buffered;
+    for(; p + 8 <= end; p += 8){
+        h ^= xxh_round(0, load64_le(p));
+        h  = rotl64(h,27) * xxh_p1 + xxh_p4;
+    }
+    if(p + 4 <= end){
+        h ^= std::uint64_t(load32_le(p)) * xxh_p1;
+        h  = rotl64(h,23) * xxh_p2 + xxh_p3;
+        p += 4;
+    }
+    for(; p < end; ++p){
+        h ^= (*p) * xxh_p5;
+        h  = rotl64(h,11) * xxh_p1;
+    }
+
+    h ^= h >> 33; h *= xxh_p2;
+    h ^= h >> 29; h *= xxh_p3;
+    h ^= h >> 32;
+    return h;
+}
+
+std::string Xxh64::hex()const{
+    return to_hex(value(),8);
+}
+
+
+
+//==============
+//=== Sha256 ===
+//==============
+namespace{
+    const std::uint32_t sha256_k[64] = {
+        0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+        0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+        0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+        0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+        0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+        0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+        0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+        0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+    };
+
+
+    void sha256_sw(std::uint32_t h[8], const unsigned char* p, size_t blocks){
+        for(; blocks != 0; --blocks, p += 64){
+            std::uint32_t w[64];
+            for(int i = 0; i < 16; ++i){w[i] = load32_be(p + 4*i);}
+            for(int i = 16; i < 64; ++i){
+                const std::uint32_t s0 = rotr32(w[i-15],7) ^ rotr32(w[i-15],18) ^ (w[i-15] >> 3);
+                const std::uint32_t s1 = rotr32(w[i-2],17) ^ rotr32(w[i-2],19)  ^ (w[i-2]  >> 10);
+                w[i] = w[i-16] + s0 + w[i-7] + s1;
+            }
+
+            std::uint32_t a=h[0], b=h[1], c=h[2], d=h[3], e=h[4], f=h[5], g=h[6], k=h[7];
+            for(int i = 0; i < 64; ++i){
+                const std::uint32_t S1 = rotr32(e,6) ^ rotr32(e,11) ^ rotr32(e,25);
+                const std::uint32_t ch = (e & f) ^ (~e & g);
+                const std::uint32_t t1 = k + S1 + ch + sha256_k[i] + w[i];
+                const std::uint32_t S0 = rotr32(a,2) ^ rotr32(a,13) ^ rotr32(a,22);
+                const std::uint32_t mj = (a & b) ^ (a & c) ^ (b & c);
+                const std::uint32_t t2 = S0 + mj;
+                k = g; g = f; f = e; e = d + t1;
+                d = c; c = b; b = a; a = t1 + t2;
+            }
+            h[0]+=a; h[1]+=b; h[2]+=c; h[3]+=d; h[4]+=e; h[5]+=f; h[6]+=g; h[7]+=k;
+        }
+    }
+
+
+#if defined(CURL_CPP_SHA256_SHANI)
+    //m[j%4] holds the message words 4j..4j+3, the state is kept as ABEF and CDGH
+    __attribute__((target("sha,sse4.1")))
+    void sha256_hw(std::uint32_t h[8], const unsigned char* p, size_t blocks){
+        const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+        __m128i t  = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h  )), 0xB1); //CDAB
+        __m128i s1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h+4)), 0x1B); //EFGH
+        __m128i s0 = _mm_alignr_epi8(t, s1, 8);    //ABEF
+        s1         = _mm_blend_epi16(s1, t, 0xF0); //CDGH
+
+        for(; blocks != 0; --blocks, p += 64){
+            const __m128i s0_save = s0;
+            const __m128i s1_save = s1;
+            __m128i m[4];
+
+            for(int j = 0; j < 16; ++j){
+                if(j < 4){
+                    m[j] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16*j)), bswap);
+                }else{
+                    __m128i x = _mm_sha256msg1_epu32(m[j&3], m[(j+1)&3]);
+                    x         = _mm_add_epi32(x, _mm_alignr_epi8(m[(j+3)&3], m[(j+2)&3], 4));
+                    m[j&3]    = _mm_sha256msg2_epu32(x, m[(j+3)&3]);
+                }
+                __m128i wk = _mm_add_epi32(m[j&3], _mm_loadu_si128(reinterpret_cast<const __m128i*>(sha256_k + 4*j)));
+                s1 = _mm_sha256rnds2_epu32(s1, s0, wk);
+                wk = _mm_shuffle_epi32(wk, 0x0E);
+                s0 = _mm_sha256rnds2_epu32(s0, s1, wk);
+            }
+
+            s0 = _mm_add_epi32(s0, s0_save);
+            s1 = _mm_add_epi32(s1, s1_save);
+        }
+
+        t  = _mm_shuffle_epi32(s0, 0x1B);  //FEBA
+        s1 = _mm_shuffle_epi32(s1, 0xB1);  //DCHG
+        s0 = _mm_blend_epi16(t, s1, 0xF0); //DCBA
+        s1 = _mm_alignr_epi8(s1, t, 8);    //HGFE
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(h  ), s0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(h+4), s1);
+    }
+
+    bool sha256_hw_ok(); //known answer check, see below
+
+    bool sha256_has_hw(){
+        static const bool r = __builtin_cpu_supports("sha") and __builtin_cpu_supports("sse4.1") and sha256_hw_ok();
+        return r;
+    }
+
+#elif defined(CURL_CPP_SHA256_ARM)
+    //m[j%4] holds the message words 4j..4j+3
+    void sha256_hw(std::uint32_t h[8], const unsigned char* p, size_t blocks){
+        uint32x4_t s0 = vld1q_u32(h  ); //ABCD
+        uint32x4_t s1 = vld1q_u32(h+4); //EFGH
+
+        for(; blocks != 0; --blocks, p += 64){
+            const uint32x4_t s0_save = s0;
+            const uint32x4_t s1_save = s1;
+            uint32x4_t m[4];
+
+            for(int j = 0; j < 16; ++j){
+                if(j < 4){
+                    m[j] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(p + 16*j)));
+                }else{
+                    m[j&3] = vsha256su1q_u32(vsha256su0q_u32(m[j&3], m[(j+1)&3]), m[(j+2)&3], m[(j+3)&3]);
+                }
+                const uint32x4_t wk = vaddq_u32(m[j&3], vld1q_u32(sha256_k + 4*j));
+                const uint32x4_t t  = s0;
+                s0 = vsha256hq_u32 (s0, s1, wk);
+                s1 = vsha256h2q_u32(s1, t,  wk);
+            }
+
+            s0 = vaddq_u32(s0, s0_save);
+            s1 = vaddq_u32(s1, s1_save);
+        }
+
+        vst1q_u32(h,   s0);
+        vst1q_u32(h+4, s1);
+    }
+
+    bool sha256_hw_ok();
+
+    bool sha256_has_hw(){
+        static const bool r = sha256_hw_ok();
+        return r;
+    }
+#endif
+
+#if defined(CURL_CPP_SHA256_SHANI) || defined(CURL_CPP_SHA256_ARM)
+    //the hardware path is only used if it gives the known answer : one padded block of "abc"
+    bool sha256_hw_ok(){
+        unsigned char block[64] = {'a','b','c',0x80};
+        block[63] = 24; //length in bits
+        std::uint32_t h[8] = {
+            0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19
+        };
+        const std::uint32_t expected[8] = {
+            0xba7816bf,0x8f01cfea,0x414140de,0x5dae2223,0xb00361a3,0x96177a9c,0xb410ff61,0xf20015ad
+        };
+        sha256_hw(h, block, 1);
+        return std::memcmp(h, expected, sizeof(h))==0;
+    }
+#endif
+}
+
+
+Sha256::Sha256(){
+    const std::uint32_t init[8] = {
+        0x6a09e667,0xbb67ae85,0x3c6ef372,0xa54ff53a,0x510e527f,0x9b05688c,0x1f83d9ab,0x5be0cd19
+    };
+    std::memcpy(h, init, sizeof(h));
+}
+
+void Sha256::compress(const unsigned char* p, size_t blocks){
+#if defined(CURL_CPP_SHA256_SHANI) || defined(CURL_CPP_SHA256_ARM)
+    if(sha256_has_hw()){sha256_hw(h, p, blocks); return;}
+#endif
+    sha256_sw(h, p, blocks);
+}
+
+void Sha256::update(const void* data, size_t size){
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    total += size;
+
+    if(buffered != 0){
+        const size_t n = std::min(size, 64 - buffered);
+        std::memcpy(buffer + buffered, p, n);
+        buffered += n; p += n; size -= n;
+        if(buffered < 64){return;}
+        compress(buffer, 1);
+        buffered = 0;
+    }
+
+    const size_t blocks = size / 64;
+    if(blocks != 0){
+        compress(p, blocks);
+        p += 64*blocks; size -= 64*blocks;
+    }
+
+    std::memcpy(buffer, p, size);
+    buffered = size;
+}
+
+std::string Sha256::hex()const{
+    //pad a copy, so update can still be called
+    Sha256 s(*this);
+    const std::uint64_t bits = total * 8;
+
+    unsigned char pad[72] = {0x80};
+    const size_t pad_size = (buffered < 56 ? 56 : 120) - buffered;
+    for(int i = 0; i < 8; ++i){pad[pad_size + i] = static_cast<unsigned char>(bits >> (56 - 8*i));}
+    s.update(pad, pad_size + 8);
+
+    std::string r;
+    r.reserve(64);
+    for(auto x : s.h){r += to_hex(x,4);}
+    return r;
+}
+
+
+
+
+//========================
+//=== Hashing receiver ===
+//========================
+namespace{
+    bool hex_equal(const std::string &a, const std::string &b){
+        if(a.size()!=b.size()){return false;}
+        for(size_t i = 0; i < a.size(); ++i){
+            if(std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))){return false;}
+        }
+        return true;
+    }
+}
+
+
+void details::hash_header_set(Curl_handle &curl, size_t(*fn)(char*,size_t,size_t,void*), void* userdata){
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, fn);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, userdata);
+}
+
+void details::hash_header_unset(Curl_handle &curl){
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, nullptr);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, nullptr);
+}
+
+//one call per header line, headers of redirections included
+size_t details::hash_header_parse(const char* ptr, size_t n, const std::string &name, std::string &received)noexcept{
+    //status line of a new response : forget the previous headers
+    if(n >= 5 and std::memcmp(ptr,"HTTP/",5)==0){received.clear(); return n;}
+
+    if(n <= name.size() or ptr[name.size()]!=':'){return n;}
+    for(size_t i = 0; i < name.size(); ++i){
+        if(std::tolower(static_cast<unsigned char>(ptr[i])) != std::tolower(static_cast<unsigned char>(name[i]))){return n;}
+    }
+
+    size_t b = name.size() + 1;
+    size_t e = n;
+    while(b < e and std::isspace(static_cast<unsigned char>(ptr[b]  ))){++b;}
+    while(e > b and std::isspace(static_cast<unsigned char>(ptr[e-1]))){--e;}
+    try{ received.assign(ptr + b, e - b); }
+    catch(...){return n+1;} //any return different from size * nmemb is an error
+    return n;
+}
+
+void details::hash_check(const char* url, const std::string &digest, const std::string &expected, const std::string &header, const std::string &received_header){
+    std::string e = expected;
+    if(e.empty() and !header.empty()){
+        if(received_header.empty()){throw Curl_error_hash("ERROR in curl hash check, missing header="+header, url);}
+        e = received_header;
+    }
+    if(e.empty()){return;}
+
+    if(!hex_equal(digest,e)){
+        throw Curl_error_hash("ERROR in curl hash check, expected="+e+", received="+digest, url);
+    }
+}
+
+
+
+namespace{
+//TEST CODE
+[[maybe_unused]] void must_compile(){
+    const char * ct="";
+    const std::string s;
+    std::string out;
+    Curl_handle h;
+
+    Curl_hash_check<Sha256,std::string> hs(out, "00");
+    curl_get(s,hs);
+    std::ofstream f;
+    Curl_hash_check<Crc32c,std::ofstream> hf(f, "", "x-checksum-crc32c");
+    curl_get(h,s,hf);
+    Curl_hash_check<Xxh64,std::string> hx(out);
+    curl_post_get(s,ct,hx);
+}
+
+//known answers, all fed in two parts to go through the buffering
+template<typename Hash>
+bool known_answer(const std::string &data, const std::string &expected){
+    Hash hash;
+    hash.update(data.data(), data.size()/2);
+    hash.update(data.data() + data.size()/2, data.size() - data.size()/2);
+    return hash.hex()==expected;
+}
+
+[[maybe_unused]] bool known_answers(){
+    return
+        known_answer<Crc32c>("123456789", "e3069283") and
+        known_answer<Xxh64 >("",          "ef46db3751d8e999") and
+        known_answer<Xxh64 >("abc",       "44bc2cf5ad770999") and
+        known_answer<Sha256>("abc",       "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad") and
+        known_answer<Sha256>(std::string(1000000,'a'), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+}
@@ -0,0 +1,181 @@
+/*
+Copyright (C) 2024 Pierre BLAVY
+
+This program (curl_cpp) is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software Foundation,
+Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+//This program uses curl, see curl.se
+
+#ifndef CURL_CPP_HASH_HPP_
+#define CURL_CPP_HASH_HPP_
+
+#include "curl_cpp.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+///USAGE : hash the downloaded bytes while they arrive, no second pass
+///   std::string page;
+///   curl_cpp::Curl_hash_check<curl_cpp::Sha256, std::string> sink(page, "ba7816bf...");
+///   curl_get(url, sink);   //throws Curl_error_hash on mismatch
+///   sink.digest;           //hex digest of the received bytes
+///
+///   The expected digest is either given (hex), or read from a response header :
+///   curl_cpp::Curl_hash_check<curl_cpp::Crc32c, std::ofstream> sink(file, "", "x-checksum-crc32c");
+///   When both are empty, nothing is checked and only sink.digest is computed.
+///   NOTE : with a header, the CURLOPT_HEADERFUNCTION and CURLOPT_HEADERDATA of the handle
+///   are replaced during the transfer, and reset to nullptr after it.
+///
+///   Wraps any type T with a Curl_receive_t<T>.
+///   Hash algorithms : Crc32c, Xxh64, Sha256.
+///     Users may provide their own : a default constructible class with
+///     void update(const void*, size_t) and std::string hex()const.
+
+
+namespace curl_cpp{
+
+//=======================
+//=== Hash algorithms ===
+//=======================
+
+//CRC-32C (Castagnoli). Uses the SSE4.2 / ARMv8 crc32 instructions when the CPU has them.
+struct Crc32c{
+    void          update(const void* data, size_t size);
+    std::uint32_t value()const{return ~crc;}
+    std::string   hex  ()const; //8 hex digits, big endian
+
+private:
+    std::uint32_t crc = 0xFFFFFFFF;
+};
+
+
+//XXH64, seed 0 by default
+struct Xxh64{
+    explicit Xxh64(std::uint64_t seed = 0);
+    void          update(const void* data, size_t size);
+    std::uint64_t value()const;
+    std::string   hex  ()const; //16 hex digits, big endian (xxhsum canonical form)
+
+private:
+    std::uint64_t seed;
+    std::uint64_t v[4];
+    unsigned char buffer[32];
+    size_t        buffered = 0;
+    std::uint64_t total    = 0;
+};
+
+
+//SHA-256. Uses the SHA-NI / ARMv8 sha2 instructions when the CPU has them.
+struct Sha256{
+    Sha256();
+    void        update(const void* data, size_t size);
+    std::string hex()const; //64 hex digits
+
+private:
+    void compress(const unsigned char* p, size_t blocks); //blocks of 64 bytes
+
+    std::uint32_t h[8];
+    unsigned char buffer[64];
+    size_t        buffered = 0;
+    std::uint64_t total    = 0;
+};
+
+
+
+
+//========================
+//=== Hashing receiver ===
+//========================
+
+template<typename Hash, typename T>
+struct Curl_hash_check{
+    typedef Hash hash_type;
+    typedef T    wrapped_type;
+
+    Curl_hash_check(T &out_, std::string expected_ = "", std::string header_ = ""):
+        out(out_), expected(std::move(expected_)), header(std::move(header_)){}
+
+    T          &out;
+    std::string expected;        //expected hex digest, empty = none
+    std::string header;          //response header holding the expected hex digest, empty = none
+    std::string received_header; //value of header, set during the transfer
+    std::string digest;          //hex digest of the received bytes, set by curl_get
+};
+
+
+namespace details{
+    //bury curl specific code here
+    void   hash_header_set  (Curl_handle &curl, size_t(*fn)(char*,size_t,size_t,void*), void* userdata);
+    void   hash_header_unset(Curl_handle &curl);
+    size_t hash_header_parse(const char* line, size_t size, const std::string &name, std::string &received_header)noexcept;
+    void   hash_check       (const char* url, const std::string &digest, const std::string &expected, const std::string &header, const std::string &received_header);
+}
+
+
+template<typename Hash, typename T>
+struct Curl_receive_t< Curl_hash_check<Hash,T>, std::enable_if_t< Curl_receive_t<T>::value > >{
+    Curl_receive_t()=delete;
+    static constexpr bool value =true;
+
+    typedef Curl_receive_t<T> wrapped_t;
+
+    struct Curl_wrap_hash{
+        typename wrapped_t::prepared_type wrapped;
+        Hash                              hash;
+    };
+
+    typedef Curl_hash_check<Hash,T> written_type;
+    typedef Curl_wrap_hash          prepared_type;
+
+    static prepared_type prepare(Curl_handle &curl, const char* url, written_type &w){
+        w.digest.clear();
+        w.received_header.clear();
+        prepared_type p{wrapped_t::prepare(curl,url,w.out), Hash()};
+        //w outlives the transfer, unlike p : give it to the header callback
+        if(!w.header.empty()){details::hash_header_set(curl, header, static_cast<void*>(&w));}
+        return p;
+    }
+
+    static size_t header(char *ptr, size_t size, size_t nmemb, void *userdata)noexcept{
+        written_type *w = static_cast<written_type*>(userdata);
+        return details::hash_header_parse(ptr, size*nmemb, w->header, w->received_header);
+    }
+
+    static size_t receive(void *ptr, size_t size, size_t nmemb, void *stream)noexcept{
+        prepared_type *p = static_cast<prepared_type*>(stream);
+        const size_t r = wrapped_t::receive(ptr, size, nmemb, static_cast<void*>(&p->wrapped));
+        if(r == size*nmemb){p->hash.update(ptr, size*nmemb);}
+        return r;
+    }
+
+    static void finish(Curl_handle &curl, const char* url, written_type &w, prepared_type &p){
+        try{
+            wrapped_t::finish(curl, url, w.out, p.wrapped);
+        }catch(...){
+            if(!w.header.empty()){details::hash_header_unset(curl);}
+            throw;
+        }
+        if(!w.header.empty()){details::hash_header_unset(curl);}
+
+        w.digest = p.hash.hex();
+        details::hash_check(url, w.digest, w.expected, w.header, w.received_header);
+    }
+};
+
+
+}//end namespace curl_cpp
+
+#endif // CURL_CPP_HASH_HPP_
@@ -0,0 +1,268 @@
+/*
+Copyright (C) 2024 Pierre BLAVY
+
+This program (curl_cpp) is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software Foundation,
+Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+//This program uses curl, see curl.se
+
+#ifndef CURL_CPP_OPTIONS_HPP_
+#define CURL_CPP_OPTIONS_HPP_
+
+#include "curl_cpp.hpp"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+///USAGE : typed curl options presets, checked at compile time, applied once per handle
+///   constexpr auto preset = curl_cpp::curl_options(
+///       curl_cpp::curl_option<CURLOPT_TIMEOUT>(10),
+///       curl_cpp::curl_option<CURLOPT_USERAGENT>("my_agent")
+///   );
+///   constexpr auto more = preset | curl_cpp::curl_option<CURLOPT_TCP_KEEPALIVE>(1);
+///
+///   curl_cpp::Curl_handle h(more);       //options set here, once
+///   curl_get(h, url, append_here);       //only url and output are set here
+///
+///   A value whose type does not match the option type is a compile error :
+///     long options      : integer, bool or enum (converted to long)
+///     curl_off_t options: integer               (converted to curl_off_t)
+///     string options    : const char* (string literal) or nullptr
+///     slist options     : curl_slist* or nullptr
+///     other pointers    : object pointer or nullptr
+///     function options  : function pointer or nullptr
+///     blob options      : curl_blob*
+///   Errors from curl_easy_setopt are thrown as Curl_error by apply.
+
+
+namespace curl_cpp{
+
+namespace details{
+    //pointer options, split as in curl/typecheck-gcc.h : curl.h gives them the same CURLOPTTYPE.
+    //Pointer options missing here (deprecated, or added by a newer libcurl) accept any object pointer.
+    constexpr bool is_string_option(CURLoption opt){
+        switch(opt){
+            case CURLOPT_ABSTRACT_UNIX_SOCKET:     case CURLOPT_ACCEPT_ENCODING:       case CURLOPT_CAINFO:
+            case CURLOPT_CAPATH:                   case CURLOPT_COOKIE:                case CURLOPT_COOKIEFILE:
+            case CURLOPT_COOKIEJAR:                case CURLOPT_COOKIELIST:            case CURLOPT_CRLFILE:
+            case CURLOPT_CUSTOMREQUEST:            case CURLOPT_DEFAULT_PROTOCOL:      case CURLOPT_DNS_INTERFACE:
+            case CURLOPT_DNS_LOCAL_IP4:            case CURLOPT_DNS_LOCAL_IP6:         case CURLOPT_DNS_SERVERS:
+            case CURLOPT_DOH_URL:                  case CURLOPT_FTP_ACCOUNT:           case CURLOPT_FTP_ALTERNATIVE_TO_USER:
+            case CURLOPT_FTPPORT:                  case CURLOPT_INTERFACE:             case CURLOPT_ISSUERCERT:
+            case CURLOPT_KEYPASSWD:                case CURLOPT_LOGIN_OPTIONS:         case CURLOPT_MAIL_AUTH:
+            case CURLOPT_MAIL_FROM:                case CURLOPT_NETRC_FILE:            case CURLOPT_NOPROXY:
+            case CURLOPT_PASSWORD:                 case CURLOPT_PINNEDPUBLICKEY:       case CURLOPT_PRE_PROXY:
+            case CURLOPT_PROXY:                    case CURLOPT_PROXY_CAINFO:          case CURLOPT_PROXY_CAPATH:
+            case CURLOPT_PROXY_CRLFILE:            case CURLOPT_PROXY_KEYPASSWD:       case CURLOPT_PROXY_PINNEDPUBLICKEY:
+            case CURLOPT_PROXY_SERVICE_NAME:       case CURLOPT_PROXY_SSL_CIPHER_LIST: case CURLOPT_PROXY_SSLCERT:
+            case CURLOPT_PROXY_SSLCERTTYPE:        case CURLOPT_PROXY_SSLKEY:          case CURLOPT_PROXY_SSLKEYTYPE:
+            case CURLOPT_PROXY_TLS13_CIPHERS:      case CURLOPT_PROXY_TLSAUTH_PASSWORD:case CURLOPT_PROXY_TLSAUTH_TYPE:
+            case CURLOPT_PROXY_TLSAUTH_USERNAME:   case CURLOPT_PROXYPASSWORD:         case CURLOPT_PROXYUSERNAME:
+            case CURLOPT_PROXYUSERPWD:             case CURLOPT_RANGE:                 case CURLOPT_REFERER:
+            case CURLOPT_REQUEST_TARGET:           case CURLOPT_RTSP_SESSION_ID:       case CURLOPT_RTSP_STREAM_URI:
+            case CURLOPT_RTSP_TRANSPORT:           case CURLOPT_SERVICE_NAME:          case CURLOPT_SSH_HOST_PUBLIC_KEY_MD5:
+            case CURLOPT_SSH_KNOWNHOSTS:           case CURLOPT_SSH_PRIVATE_KEYFILE:   case CURLOPT_SSH_PUBLIC_KEYFILE:
+            case CURLOPT_SSLCERT:                  case CURLOPT_SSLCERTTYPE:           case CURLOPT_SSLENGINE:
+            case CURLOPT_SSLKEY:                   case CURLOPT_SSLKEYTYPE:            case CURLOPT_SSL_CIPHER_LIST:
+            case CURLOPT_TLS13_CIPHERS:            case CURLOPT_TLSAUTH_PASSWORD:      case CURLOPT_TLSAUTH_TYPE:
+            case CURLOPT_TLSAUTH_USERNAME:         case CURLOPT_UNIX_SOCKET_PATH:      case CURLOPT_URL:
+            case CURLOPT_USERAGENT:                case CURLOPT_USERNAME:              case CURLOPT_USERPWD:
+            case CURLOPT_XOAUTH2_BEARER:
+        #if LIBCURL_VERSION_NUM >= 0x074001 //7.64.1
+            case CURLOPT_ALTSVC:
+        #endif
+        #if LIBCURL_VERSION_NUM >= 0x074200 //7.66.0
+            case CURLOPT_SASL_AUTHZID:
+        #endif
+        #if LIBCURL_VERSION_NUM >= 0x074700 //7.71.0
+            case CURLOPT_PROXY_ISSUERCERT:
+        #endif
+        #if LIBCURL_VERSION_NUM >= 0x074900 //7.73.0
+            case CURLOPT_SSL_EC_CURVES:
+        #endif
+        #if LIBCURL_VERSION_NUM >= 0x074A00 //7.74.0
+            case CURLOPT_HSTS:
+        #endif
+        #if LIBCURL_VERSION_NUM >= 0x074B00 //7.75.0
+            case CURLOPT_AWS_SIGV4:
+        #endif
+        #if LIBCURL_VERSION_NUM >= 0x075000 //7.80.0
+            case CURLOPT_SSH_HOST_PUBLIC_KEY_SHA256:
+        #endif
+        #if LIBCURL_VERSION_NUM >= 0x075500 //7.85.0
+            case CURLOPT_PROTOCOLS_STR:
+            case CURLOPT_REDIR_PROTOCOLS_STR:
+        #endif
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    constexpr bool is_slist_option(CURLoption opt){
+        switch(opt){
+            case CURLOPT_HTTP200ALIASES: case CURLOPT_HTTPHEADER: case CURLOPT_MAIL_RCPT:
+            case CURLOPT_POSTQUOTE:      case CURLOPT_PREQUOTE:   case CURLOPT_PROXYHEADER:
+            case CURLOPT_QUOTE:          case CURLOPT_RESOLVE:    case CURLOPT_TELNETOPTIONS:
+            case CURLOPT_CONNECT_TO:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    //pseudo option types, split from CURLOPTTYPE_OBJECTPOINT
+    constexpr int curl_option_string = -1;
+    constexpr int curl_option_slist  = -2;
+
+    //option type, from the CURLOPTTYPE_* ranges of curl.h
+    template<CURLoption Opt>
+    struct Curl_option_kind{
+        static constexpr int range = static_cast<int>(Opt) / 10000 * 10000;
+        static constexpr int value =
+            range != CURLOPTTYPE_OBJECTPOINT ? range              :
+            is_string_option(Opt)            ? curl_option_string :
+            is_slist_option (Opt)            ? curl_option_slist  :
+                                               range;
+    };
+
+    template<typename V>
+    struct Is_function_pointer{
+        static constexpr bool value = std::is_pointer<V>::value and std::is_function< std::remove_pointer_t<V> >::value;
+    };
+
+    template<typename V>
+    struct Is_object_pointer{
+        static constexpr bool value = std::is_pointer<V>::value and not std::is_function< std::remove_pointer_t<V> >::value;
+    };
+
+    //stored type of an option value, void if V does not match the option
+    template<int Kind, typename V, typename Enable=void>
+    struct Curl_option_value{typedef void type;};
+
+    template<typename V>
+    struct Curl_option_value<CURLOPTTYPE_LONG, V, std::enable_if_t< std::is_integral<V>::value or std::is_enum<V>::value > >{typedef long type;};
+
+    template<typename V>
+    struct Curl_option_value<CURLOPTTYPE_OFF_T, V, std::enable_if_t< std::is_integral<V>::value > >{typedef curl_off_t type;};
+
+    template<typename V>
+    struct Curl_option_value<CURLOPTTYPE_OBJECTPOINT, V, std::enable_if_t< Is_object_pointer<std::decay_t<V> >::value > >{typedef std::decay_t<V> type;};
+
+    template<>
+    struct Curl_option_value<CURLOPTTYPE_OBJECTPOINT, std::nullptr_t>{typedef std::nullptr_t type;};
+
+    template<typename V>
+    struct Curl_option_value<curl_option_string, V, std::enable_if_t< std::is_same<V,const char*>::value or std::is_same<V,char*>::value > >{typedef const char* type;};
+
+    template<>
+    struct Curl_option_value<curl_option_string, std::nullptr_t>{typedef std::nullptr_t type;};
+
+    template<>
+    struct Curl_option_value<curl_option_slist, curl_slist*>{typedef curl_slist* type;};
+
+    template<>
+    struct Curl_option_value<curl_option_slist, std::nullptr_t>{typedef std::nullptr_t type;};
+
+    template<typename V>
+    struct Curl_option_value<CURLOPTTYPE_FUNCTIONPOINT, V, std::enable_if_t< Is_function_pointer<std::decay_t<V> >::value > >{typedef std::decay_t<V> type;};
+
+    template<>
+    struct Curl_option_value<CURLOPTTYPE_FUNCTIONPOINT, std::nullptr_t>{typedef std::nullptr_t type;};
+
+    template<>
+    struct Curl_option_value<CURLOPTTYPE_BLOB, curl_blob*>{typedef curl_blob* type;};
+
+    //bury curl specific code here
+    void curl_setopt_throw(CURLcode res, CURLoption opt);
+}
+
+
+
+//===================
+//=== Curl_option ===
+//===================
+
+template<CURLoption Opt, typename V>
+struct Curl_option{
+    static constexpr CURLoption option = Opt;
+    typedef V value_type;
+
+    V value;
+
+    void apply(Curl_handle &curl)const{
+        details::curl_setopt_throw( curl_easy_setopt(curl.get(), Opt, value), Opt );
+    }
+};
+
+
+template<CURLoption Opt, typename V>
+constexpr auto curl_option(V v){
+    typedef typename details::Curl_option_value<details::Curl_option_kind<Opt>::value, V>::type stored_type;
+    static_assert(not std::is_void<stored_type>::value, "curl_cpp::curl_option : value type does not match the option type (see CURLOPTTYPE_* in curl.h)");
+    return Curl_option<Opt,stored_type>{static_cast<stored_type>(v)};
+}
+
+
+
+
+//====================
+//=== Curl_options ===
+//====================
+
+template<typename... Os>
+struct Curl_options{
+    static constexpr bool is_curl_options = true;
+
+    std::tuple<Os...> options;
+
+    constexpr Curl_options(const Os&... o):options(o...){}
+    constexpr explicit Curl_options(const std::tuple<Os...> &t):options(t){}
+
+    //set all options, in order
+    void apply(Curl_handle &curl)const{
+        apply_impl(curl, std::index_sequence_for<Os...>());
+    }
+
+private:
+    template<size_t... I>
+    void apply_impl(Curl_handle &curl, std::index_sequence<I...>)const{
+        const int unused[] = {0, (std::get<I>(options).apply(curl), 0)...};
+        (void)unused;
+    }
+};
+
+
+template<typename... Os>
+constexpr Curl_options<Os...> curl_options(const Os&... o){return Curl_options<Os...>(o...);}
+
+
+//--- compose presets ---
+template<typename... Os, CURLoption Opt, typename V>
+constexpr Curl_options<Os...,Curl_option<Opt,V> > operator|(const Curl_options<Os...> &a, const Curl_option<Opt,V> &b){
+    return Curl_options<Os...,Curl_option<Opt,V> >( std::tuple_cat(a.options, std::make_tuple(b)) );
+}
+
+template<typename... Os, typename... Ps>
+constexpr Curl_options<Os...,Ps...> operator|(const Curl_options<Os...> &a, const Curl_options<Ps...> &b){
+    return Curl_options<Os...,Ps...>( std::tuple_cat(a.options, b.options) );
+}
+
+
+}//end namespace curl_cpp
+
+#endif // CURL_CPP_OPTIONS_HPP_
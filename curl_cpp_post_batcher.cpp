@@ -0,0 +1,325 @@
+/*
+Copyright (C) 2024 Pierre BLAVY
+
+This program (curl_cpp) is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software Foundation,
+Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+//This program uses curl, see curl.se
+
+
+#include "curl_cpp_post_batcher.hpp"
+#include "curl_cpp_options.hpp"
+#include <curl/curl.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+
+using namespace curl_cpp;
+
+
+namespace{
+    inline void curlm_throw(CURLMcode res, const std::string &prefix){
+        if(res != CURLM_OK){
+            throw curl_cpp::Curl_error(prefix+", message="+curl_multi_strerror(res));
+        }
+    }
+}
+
+
+
+//=== Multi_handle ===
+
+Curl_post_batcher::Multi_handle::Multi_handle(){
+    multi = curl_multi_init();
+    if(!multi){throw Curl_error("ERROR in curl : cannot initialize curl multi");}
+}
+
+Curl_post_batcher::Multi_handle::~Multi_handle(){
+    curl_multi_cleanup(multi);
+}
+
+
+
+//=== Curl_post_batcher ===
+
+Curl_post_batcher::Curl_post_batcher(const options_type &o):opt(o){
+    if(opt.max_in_flight==0){throw Curl_error("ERROR in curl post batcher : max_in_flight must be >0");}
+
+    slots.reserve(opt.max_in_flight);
+    for(size_t i = 0; i < opt.max_in_flight; ++i){
+        slots.emplace_back(new Slot);
+        Slot &s = *slots.back();
+        //set once, only url and body change between sends
+        curl_easy_setopt(s.curl, CURLOPT_WRITEFUNCTION, details::curl_discard); //the server answer must not go to stdout (curl default)
+        curl_easy_setopt(s.curl, CURLOPT_PRIVATE, static_cast<void*>(&s));
+        s.curl.unix_sockets = opt.unix_sockets;
+    }
+}
+
+
+Curl_post_batcher::~Curl_post_batcher(){
+    const auto deadline = clock_type::now() + opt.drain_timeout;
+    try{
+        while(true){
+            bool pending = false;
+            for(auto &e : endpoints){
+                if(!send(e.first,e.second,false)){pending = true;}
+            }
+            if(!pending and in_flight()==0){break;}
+
+            const auto now = clock_type::now();
+            if(now >= deadline){break;}
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+            curl_multi_poll(multi.multi, nullptr, 0, static_cast<int>(std::min<long long>(left+1, 1000)), nullptr);
+            progress();
+        }
+    }
+    catch(...){}
+
+    //abandon what is still in flight
+
+    for(auto &s : slots){
+        if(s->busy){curl_multi_remove_handle(multi.multi, s->curl);}
+    }
+}
+
+
+
+//--- add a record ---
+
+void Curl_post_batcher::post(const std::string &url, const char* data){
+    post(url, data, std::strlen(data));
+}
+
+void Curl_post_batcher::post(const std::string &url, const char* data, size_t size){
+    //report earlier batches before accepting the record
+    rethrow();
+
+    switch(opt.framing){
+        case Batch_framing::newline:
+            if(size and std::memchr(data,'\n',size)){throw Curl_error("ERROR in curl post batcher : record contains '\\n', not allowed with newline framing", url.c_str());}
+            break;
+        case Batch_framing::length_prefix:
+            if(size > UINT32_MAX){throw Curl_error("ERROR in curl post batcher : record too large for length_prefix framing", url.c_str());}
+            break;
+    }
+
+    Endpoint &e = endpoints[url];
+    if(e.records==0){
+        e.first = clock_type::now();
+        next_linger = std::min(next_linger, e.first + opt.linger);
+    }
+
+    switch(opt.framing){
+        case Batch_framing::newline:
+            e.buffer.reserve(e.buffer.size() + size + 1);
+            e.buffer.append(data, size);
+            e.buffer.push_back('\n');
+            break;
+
+        case Batch_framing::length_prefix:{
+            const std::uint32_t n = static_cast<std::uint32_t>(size);
+            const char prefix[4] = {
+                static_cast<char>((n >> 24) & 0xFF),
+                static_cast<char>((n >> 16) & 0xFF),
+                static_cast<char>((n >>  8) & 0xFF),
+                static_cast<char>( n        & 0xFF)
+            };
+            e.buffer.reserve(e.buffer.size() + size + 4);
+            e.buffer.append(prefix, 4);
+            e.buffer.append(data, size);
+            break;
+        }
+    }
+    ++e.records;
+
+    if( (opt.max_bytes   != 0 and e.buffer.size() >= opt.max_bytes  ) or
+        (opt.max_records != 0 and e.records       >= opt.max_records)
+    ){
+        send(url,e,true);
+    }
+
+    //errors found from here are thrown by the next call, the record is already accepted
+    poll_impl();
+}
+
+
+
+//--- send ---
+
+void Curl_post_batcher::flush(const std::string &url){
+    progress(); //release finished slots first
+    auto f = endpoints.find(url);
+    if(f!=endpoints.end()){send(f->first,f->second,false);}
+    rethrow();
+}
+
+void Curl_post_batcher::flush(){
+    progress();
+    for(auto &e : endpoints){send(e.first,e.second,false);}
+    rethrow();
+}
+
+void Curl_post_batcher::poll(){
+    poll_impl();
+    rethrow();
+}
+
+void Curl_post_batcher::wait(){
+    for(auto &e : endpoints){send(e.first,e.second,true);}
+    while(in_flight()!=0){
+        CURLMcode r = curl_multi_poll(multi.multi, nullptr, 0, 1000, nullptr);
+        curlm_throw(r,"ERROR in curl post batcher, poll");
+        progress();
+    }
+    rethrow();
+}
+
+size_t Curl_post_batcher::in_flight()const{
+    return busy_slots;
+}
+
+
+
+//--- private ---
+
+//called for each record : no scan of the endpoints, and no perform when nothing is in flight
+void Curl_post_batcher::poll_impl(){
+    if(busy_slots!=0){progress();} //release finished slots first
+    if(next_linger != clock_type::time_point::max() and clock_type::now() >= next_linger){linger_scan();}
+}
+
+void Curl_post_batcher::linger_scan(){
+    const auto now = clock_type::now();
+    next_linger = clock_type::time_point::max();
+    for(auto &e : endpoints){
+        if(e.second.records==0){continue;}
+        const auto deadline = e.second.first + opt.linger;
+        if(now >= deadline and send(e.first,e.second,false)){continue;}
+        next_linger = std::min(next_linger, deadline); //not due, or no free slot
+    }
+}
+
+
+bool Curl_post_batcher::send(const std::string &url, Endpoint &e, bool block){
+    if(e.records==0){return true;}
+
+    Slot *sp = acquire(block);
+    if(!sp){return false;}
+    Slot &s = *sp;
+
+    //may throw : set it while the records are still in the endpoint
+    details::curl_set_url(s.curl, url.c_str());
+
+    //swap buffers : the endpoint gets back the (empty) capacity of the previous body
+    s.url = url;
+    s.body.swap(e.buffer);
+    e.records = 0;
+
+    curl_easy_setopt(s.curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(s.body.size()) ); //set size first, body may contain '\0'
+    curl_easy_setopt(s.curl, CURLOPT_POSTFIELDS, s.body.data());
+
+    CURLMcode r = curl_multi_add_handle(multi.multi, s.curl);
+    curlm_throw(r,"ERROR in curl post batcher, add handle, url="+url);
+    s.busy = true;
+    ++busy_slots;
+
+    progress(); //start the transfer now
+    return true;
+}
+
+
+auto Curl_post_batcher::acquire(bool block)->Slot*{
+    while(true){
+        for(auto &s : slots){if(!s->busy){return s.get();}}
+        if(!block){return nullptr;}
+        CURLMcode r = curl_multi_poll(multi.multi, nullptr, 0, 1000, nullptr);
+        curlm_throw(r,"ERROR in curl post batcher, poll");
+        progress();
+    }
+}
+
+
+void Curl_post_batcher::progress(){
+    int running = 0;
+    CURLMcode r = curl_multi_perform(multi.multi, &running);
+    curlm_throw(r,"ERROR in curl post batcher, perform");
+
+    int queued = 0;
+    while(CURLMsg *m = curl_multi_info_read(multi.multi, &queued)){
+        if(m->msg != CURLMSG_DONE){continue;}
+
+        void *p = nullptr;
+        curl_easy_getinfo(m->easy_handle, CURLINFO_PRIVATE, &p);
+        Slot &s = *static_cast<Slot*>(p);
+
+        if(error.empty()){
+            if(m->data.result != CURLE_OK){
+                error = std::string("ERROR in curl post batcher, message=") + curl_easy_strerror(m->data.result) + ", url=" + s.url;
+            }else{
+                long http_code = 0;
+                curl_easy_getinfo(m->easy_handle, CURLINFO_RESPONSE_CODE, &http_code);
+                if(http_code < 200 or http_code >= 300){ //collectors often answer 202 or 204
+                    error      = "ERROR in curl post batcher, http_error="+std::to_string(http_code)+", url="+s.url;
+                    error_http = http_code;
+                }
+            }
+        }
+
+        curl_multi_remove_handle(multi.multi, m->easy_handle);
+        s.body.clear(); //keep capacity
+        s.busy = false;
+        --busy_slots;
+    }
+}
+
+
+void Curl_post_batcher::rethrow(){
+    if(error.empty()){return;}
+
+    std::string msg; msg.swap(error);
+    long http = error_http; error_http = 0;
+
+    if(http!=0){
+        Curl_error_http err(msg);
+        err.error_number = http;
+        throw err;
+    }
+    throw Curl_error(msg);
+}
+
+
+
+namespace{
+//TEST CODE
+[[maybe_unused]] void must_compile(){
+    const char * ct="";
+    const std::string s;
+
+    Curl_post_batcher b;
+    b.post(s,s);
+    b.post(s,ct);
+    b.post(s,ct,0);
+    b.poll();
+    b.flush(s);
+    b.flush();
+    b.wait();
+
+    constexpr auto preset = curl_options( curl_option<CURLOPT_TIMEOUT>(10) );
+    Curl_post_batcher bp(Curl_post_batcher_options(), preset);
+}
+}
@@ -0,0 +1,162 @@
+/*
+Copyright (C) 2024 Pierre BLAVY
+
+This program (curl_cpp) is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 3 of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; if not, write to the Free Software Foundation,
+Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+
+//This program uses curl, see curl.se
+
+#ifndef CURL_CPP_POST_BATCHER_HPP_
+#define CURL_CPP_POST_BATCHER_HPP_
+
+#include "curl_cpp.hpp"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+///USAGE :
+///   curl_cpp::Curl_post_batcher b;          //or b(options)
+///   b.post(url, record);                     //buffered, may trigger an async send
+///   b.poll();                                //call from time to time : linger timer + progress
+///   b.wait();                                //send everything and wait for the answers
+///
+///   Records posted to the same url are concatenated in a single POST body.
+///   A body is sent when one of the thresholds of Curl_post_batcher_options is reached.
+///   Sends are asynchronous (curl multi interface), at most max_in_flight at once,
+///   and reuse their handles and connections.
+///
+///   Blocking :
+///     poll and flush never block : when all the handles are busy, records stay buffered.
+///     post blocks (backpressure) when a threshold is reached and all the handles are busy.
+///     wait blocks until everything is sent.
+///
+///   Errors :
+///     Transfer errors are thrown (Curl_error, Curl_error_http) by the next call to
+///     post, flush, poll or wait. When post throws such an error, it reports an
+///     earlier batch, and the record given to post was NOT added.
+///     Records are lost with their batch : retry policies belong to the caller.
+///
+///   NOTE : there is no background thread, the linger timer is only checked by post and poll.
+///   NOTE : the handles do not follow redirections (the body would be lost), a 3xx answer is an error.
+
+
+namespace curl_cpp{
+
+//How records are delimited in a POST body
+enum class Batch_framing{
+    newline,       //record + '\n'. Records containing '\n' are rejected.
+    length_prefix  //4 bytes big endian length + record.
+};
+
+struct Curl_post_batcher_options{
+    Batch_framing framing = Batch_framing::newline;
+
+    //flush an url when any of these is reached (0 = disabled)
+    size_t                    max_bytes   = 64*1024;
+    size_t                    max_records = 1000;
+    std::chrono::milliseconds linger      {100};   //age of the oldest buffered record
+
+    size_t max_in_flight = 4; //number of concurrent POST, must be >0
+
+    std::chrono::milliseconds drain_timeout{5000}; //max time spent by the destructor to send what remains
+
+    const Curl_unix_sockets* unix_sockets = nullptr; //route hosts to unix sockets, must outlive the batcher
+};
+
+
+struct Curl_post_batcher{
+    typedef Curl_post_batcher_options options_type;
+    typedef std::chrono::steady_clock clock_type;
+
+    explicit Curl_post_batcher(const options_type &o = options_type());
+
+    //apply a Curl_options preset once to each pooled handle (see curl_cpp_options.hpp).
+    //The preset must not set CURLOPT_PRIVATE, it is used by the batcher.
+    template<typename Preset, typename = std::enable_if_t<Preset::is_curl_options> >
+    Curl_post_batcher(const options_type &o, const Preset &preset):Curl_post_batcher(o){
+        for(auto &s : slots){preset.apply(s->curl);}
+    }
+
+    //sends what remains for at most drain_timeout, then abandons the unfinished transfers.
+    //errors are lost : call wait() before to get them.
+    ~Curl_post_batcher();
+
+    //not movable, not copiable : curl keeps pointers to the in-flight bodies
+    Curl_post_batcher(Curl_post_batcher&&)=delete;
+    Curl_post_batcher(const Curl_post_batcher&)=delete;
+    Curl_post_batcher& operator=(const Curl_post_batcher&)=delete;
+
+    //--- add a record ---
+    void post(const std::string &url, const char* data, size_t size);
+    void post(const std::string &url, const std::string &data){post(url, data.data(), data.size());}
+    void post(const std::string &url, const char* data);
+
+    //--- send ---
+    void flush(const std::string &url); //send the buffered records of url (async), never blocks
+    void flush();                        //send all buffered records (async), never blocks
+    void poll();                         //flush urls older than linger, make transfers progress, never blocks
+    void wait();                         //send all buffered records and block until all transfers are done
+
+    size_t in_flight()const;
+    const options_type& options()const{return opt;}
+
+private:
+    struct Endpoint{
+        std::string       buffer;
+        size_t            records = 0;
+        clock_type::time_point first;
+    };
+
+    struct Slot{
+        Curl_handle curl;
+        std::string url;
+        std::string body;
+        bool        busy = false;
+    };
+
+    struct Multi_handle{
+        Multi_handle();
+        ~Multi_handle();
+        Multi_handle(const Multi_handle&)=delete;
+        Multi_handle& operator=(const Multi_handle&)=delete;
+        CURLM* multi=nullptr;
+    };
+
+    bool  send     (const std::string &url, Endpoint &e, bool block); //false if not sent (no free slot)
+    Slot* acquire  (bool block);      //nullptr if no free slot and not block
+    void  poll_impl();                //poll without rethrow, cheap when nothing is due
+    void  linger_scan();              //send expired endpoints, recompute next_linger
+    void  progress ();                //perform, and release finished slots, never blocks
+    void  rethrow  ();
+
+    options_type                        opt;
+    std::map<std::string,Endpoint>      endpoints;
+    std::vector<std::unique_ptr<Slot> > slots;
+    Multi_handle                        multi;
+
+    size_t                 busy_slots  = 0;                          //number of transfers in flight
+    clock_type::time_point next_linger = clock_type::time_point::max(); //earliest linger deadline, may be early, never late
+
+    //first transfer error, thrown by the next public call
+    std::string error;
+    long        error_http = 0;
+};
+
+}//end namespace curl_cpp
+
+#endif // CURL_CPP_POST_BATCHER_HPP_